@@ -0,0 +1,64 @@
+/**
+ * @file allocator-benchmark.cpp
+ * @brief This is the entry file for a benchmark comparing the allocation modes
+ * in `allocator.cpp` on the greedy algorithms. Compile it separately, for
+ * example: `g++ -std=gnu++17 -O2 allocator-benchmark.cpp -o allocator-benchmark`.
+ *
+ * Usage:
+ * ```
+ * ./allocator-benchmark [n] [m] [density] [repetitions] [generator mode]
+ * ```
+ * By default, a 20000 × 20000 Bernoulli instance with density 0.05 is solved 3
+ * times with OG under each allocation mode. Average runtimes are printed as a
+ * tab-separated table.
+ */
+#include "header.cpp"
+#include "trace.cpp"
+#include "generator.cpp"
+#include "allocator.cpp"
+#include "solver.cpp"
+
+const vector<string> kBenchmarkAlgorithmIds = {"OG"};
+
+int main (int argc, char *argv[]) {
+	int n = argc > 1 ? atoi(argv[1]) : 20000;
+	int m = argc > 2 ? atoi(argv[2]) : 20000;
+	double density = argc > 3 ? atof(argv[3]) : 0.05;
+	int repetitions = argc > 4 ? atoi(argv[4]) : 3;
+	string generator_mode = argc > 5 ? argv[5] : "bernoulli";
+
+	ofstream log_file("allocator-benchmark-log.txt");
+	cout << currentTimeMargin() << "Generating " << generator_mode << ' ' <<
+		n << " × " << m << " instance with density " << density << "..." <<
+		endl;
+	ScpGeneratorSettings settings(generator_mode, n, m, 1000, density, 1);
+	long long planted_optimum;
+	unique_ptr<ScpInstance> input(
+		generateScpInstance(settings, planted_optimum)
+	);
+
+	cout << "Algorithm";
+	for (string mode: kAllocationModes) cout << '\t' << mode;
+	cout << endl;
+	for (string algorithm_id: kBenchmarkAlgorithmIds) {
+		cout << kAlgorithms.at(algorithm_id);
+		for (string mode: kAllocationModes) {
+			unique_ptr<ScpArena> arena = createScpArena(mode);
+			double total_runtime = 0;
+			for (int i = 0; i < repetitions; i++) {
+				// Times the whole call, since copying the instance into the
+				// arena is part of the allocator's cost
+				auto start_time = system_clock::now();
+				unique_ptr<ScpSolution> solution(
+					solveScpInstance(input, algorithm_id, log_file, arena.get())
+				);
+				auto end_time = system_clock::now();
+				duration<double> elapsed = end_time - start_time;
+				total_runtime += elapsed.count();
+			}
+			cout << '\t' << total_runtime / repetitions << std::flush;
+		}
+		cout << endl;
+	}
+	log_file.close();
+}
@@ -0,0 +1,226 @@
+/**
+ * @file allocator.cpp
+ * @brief This file contains an arena allocator for the large arrays used by
+ * `solveScpInstance`, which can back them with huge pages to reduce TLB misses
+ * on large instances.
+ */
+
+/**
+ * Allocation modes
+ * +---------+---------------------------------------------------------------+
+ * |  Mode   |                          Description                          |
+ * +---------+---------------------------------------------------------------+
+ * | default | `std::allocator` (no arena)                                   |
+ * | arena   | Cache-line-aligned bump allocation from large mapped regions |
+ * | thp     | arena, with transparent huge pages requested by `madvise`     |
+ * | hugetlb | arena, backed by explicit huge pages (`MAP_HUGETLB`) when the |
+ * |         | system has reserved enough of them, and by thp otherwise      |
+ * +---------+---------------------------------------------------------------+
+ *
+ * Huge page modes require Linux; elsewhere they behave like arena.
+ *
+ * Pages are placed on NUMA nodes by first touch, i.e. on the node of the thread
+ * that first writes them. Regions are reused after `reset()` instead of being
+ * returned to the system, so an arena created and used by one worker thread
+ * keeps its memory local to that thread.
+ */
+const vector<string> kAllocationModes = {"default", "arena", "thp", "hugetlb"};
+
+const size_t kCacheLineSize = 64;
+const size_t kHugePageSize = 2 << 20; // 2 MiB, the x86-64 huge page size
+const size_t kArenaRegionSize = 64 << 20;
+
+class ScpArena {
+ public:
+	explicit ScpArena (string mode) { this->mode = mode; }
+	~ScpArena () { for (Region &region: regions) unmapRegion(region); }
+
+	string getMode () { return mode; }
+
+	// Returns `bytes` bytes aligned to `alignment` (a power of 2 that is at
+	// most `kHugePageSize`), mapping a new region if the current one is full.
+	void *allocate (size_t bytes, size_t alignment) {
+		if (!regions.empty()) {
+			Region &region = regions.back();
+			size_t start = (region.used + alignment - 1) & ~(alignment - 1);
+			if (start + bytes <= region.size) {
+				region.used = start + bytes;
+				return region.base + start;
+			}
+		}
+		size_t size = max(kArenaRegionSize, bytes);
+		size = (size + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+		regions.push_back(mapRegion(size));
+		regions.back().used = bytes;
+		return regions.back().base;
+	}
+
+	// Frees everything allocated so far. The memory is kept for reuse, merged
+	// into one region if it had to grow.
+	void reset () {
+		if (regions.size() > 1) {
+			size_t total_size = 0;
+			for (Region &region: regions) {
+				total_size += region.size;
+				unmapRegion(region);
+			}
+			regions = {mapRegion(total_size)};
+		}
+		for (Region &region: regions) region.used = 0;
+	}
+
+ private:
+	struct Region {
+		char *base;
+		size_t size, used;
+		bool huge_tlb;
+	};
+
+	string mode;
+	vector<Region> regions;
+
+	// Maps `size` bytes (a multiple of `kHugePageSize`) aligned to
+	// `kHugePageSize`, so that every page of the region can be a huge page.
+	Region mapRegion (size_t size) {
+		Region region = {nullptr, size, 0, false};
+#if defined(__unix__) || defined(__APPLE__)
+#ifdef MAP_HUGETLB
+		if (mode == "hugetlb") {
+			void *base = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+				MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+			if (base != MAP_FAILED) {
+				region.base = (char *)base, region.huge_tlb = true;
+				return region;
+			}
+		}
+#endif
+		// Over-maps by a huge page, then trims both ends to align the region
+		size_t padded_size = size + kHugePageSize;
+		void *mapped = mmap(nullptr, padded_size, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (mapped == MAP_FAILED) throw std::bad_alloc();
+		char *padded = (char *)mapped;
+		uintptr_t address = (uintptr_t)padded;
+		char *base = padded + ((kHugePageSize - address % kHugePageSize) %
+			kHugePageSize);
+		if (base > padded) munmap(padded, base - padded);
+		if (padded + padded_size > base + size)
+			munmap(base + size, padded + padded_size - (base + size));
+		region.base = base;
+#ifdef MADV_HUGEPAGE
+		if (mode == "thp" || mode == "hugetlb")
+			madvise(region.base, size, MADV_HUGEPAGE);
+#endif
+#else
+		region.base = (char *)::operator new(size,
+			std::align_val_t(kHugePageSize));
+#endif
+		return region;
+	}
+
+	void unmapRegion (Region &region) {
+#if defined(__unix__) || defined(__APPLE__)
+		munmap(region.base, region.size);
+#else
+		::operator delete(region.base, std::align_val_t(kHugePageSize));
+#endif
+	}
+};
+
+/**
+ * @brief Creates an arena for an allocation mode.
+ *
+ * @return ScpArena* The arena, or null for "default" (`std::allocator`)
+ */
+unique_ptr<ScpArena> createScpArena (string mode) {
+	if (mode == "default") return unique_ptr<ScpArena>();
+	return unique_ptr<ScpArena>(new ScpArena(mode));
+}
+
+/**
+ * @brief Rewinds an arena when it goes out of scope, freeing all allocations
+ * made while it was alive. Declare it before the containers it outlives.
+ */
+class ScpArenaScope {
+ public:
+	explicit ScpArenaScope (ScpArena *arena) { this->arena = arena; }
+	~ScpArenaScope () { if (arena) arena->reset(); }
+
+ private:
+	ScpArena *arena;
+};
+
+/**
+ * @brief A standard allocator that allocates from an `ScpArena` at cache line
+ * alignment, or from `std::allocator` when the arena is null. Deallocation is a
+ * no-op for arenas; memory is reclaimed by `ScpArena::reset()`.
+ */
+template <typename T>
+struct ScpAllocator {
+	typedef T value_type;
+	ScpArena *arena;
+
+	ScpAllocator (ScpArena *arena = nullptr) { this->arena = arena; }
+	template <typename U>
+	ScpAllocator (const ScpAllocator<U> &other) { arena = other.arena; }
+
+	T *allocate (size_t count) {
+		if (!arena) return std::allocator<T>().allocate(count);
+		return (T *)arena->allocate(count * sizeof(T),
+			max(alignof(T), kCacheLineSize));
+	}
+	void deallocate (T *pointer, size_t count) {
+		if (!arena) std::allocator<T>().deallocate(pointer, count);
+	}
+
+	template <typename U>
+	bool operator== (const ScpAllocator<U> &other) const {
+		return arena == other.arena;
+	}
+	template <typename U>
+	bool operator!= (const ScpAllocator<U> &other) const {
+		return arena != other.arena;
+	}
+};
+
+template <typename T>
+using ScpVector = vector<T, ScpAllocator<T>>;
+
+/**
+ * @brief A range of indices within an `ScpAdjacency`, usable in range-based
+ * for loops.
+ */
+struct ScpIndexRange {
+	const int *first, *last;
+
+	const int *begin () const { return first; }
+	const int *end () const { return last; }
+	size_t size () const { return last - first; }
+};
+
+/**
+ * @brief Stores a list of index lists (such as the rows or columns of an
+ * instance) contiguously, so that all lists share two arrays instead of
+ * occupying one heap block each.
+ */
+struct ScpAdjacency {
+	ScpVector<long long> starts; // List i is entries[starts[i]...starts[i+1]]
+	ScpVector<int> entries;
+
+	ScpAdjacency (const vector<vector<int>> &lists, ScpArena *arena) :
+		starts(ScpAllocator<long long>(arena)),
+		entries(ScpAllocator<int>(arena)) {
+		starts.reserve(lists.size() + 1);
+		starts.push_back(0);
+		for (const vector<int> &list: lists)
+			starts.push_back(starts.back() + list.size());
+		entries.reserve(starts.back());
+		for (const vector<int> &list: lists)
+			entries.insert(entries.end(), list.begin(), list.end());
+	}
+
+	ScpIndexRange operator[] (int i) const {
+		return {entries.data() + starts[i], entries.data() + starts[i + 1]};
+	}
+	int size () const { return starts.size() - 1; }
+};
@@ -55,6 +55,7 @@ unique_ptr<ScpInstance> generateScpInstance (
 void writeScpInstance (
 	unique_ptr<ScpInstance> &input, string input_format, string input_path
 ) {
+	ScpTraceSpan span("write-input", input_path);
 	ofstream fout;
 	fout.open(input_path);
 	fout << input->n << ' ' << input->m << '\n';
@@ -83,4 +84,338 @@ void writeScpInstance (
 		return;
 	}
 	fout.close();
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Settings for the structured instance generators.
+ *
+ * Generator modes
+ * +-----------+------------------------------------------------------------+
+ * |   Mode    |                        Description                         |
+ * +-----------+------------------------------------------------------------+
+ * | bernoulli | The original generator, `generateScpInstance(n, m, ...)`    |
+ * | uniform   | Every cell is filled with probability `density`            |
+ * | power-law | Column sizes follow a Pareto distribution with exponent    |
+ * |           | `power_law_exponent` and mean `density * n`                |
+ * | banded    | Rows are ordered (like trips in time) and each column fills |
+ * |           | a window of up to `band_width` consecutive rows with        |
+ * |           | probability `density`, resembling crew-scheduling rails    |
+ * +-----------+------------------------------------------------------------+
+ *
+ * Every mode except bernoulli also supports:
+ * - `planted_cover_size` > 0: Plants an optimal cover of that many columns
+ *   partitioning the rows (contiguous blocks in banded mode). Every other
+ *   column's cost is raised to at least the sum of its rows' shares of the
+ *   planted costs, which makes those shares a feasible LP dual, so the planted
+ *   cover's total cost is the optimum.
+ * - `cost_correlation` in [0, 1]: Blends uniform costs (0) with costs
+ *   proportional to column size (1), where a column of average size costs
+ *   about `max_cost / 2`. Correlated costs may exceed `max_cost`.
+ */
+struct ScpGeneratorSettings {
+	string mode;
+	int n, m, max_cost;
+	double density;
+	int seed;
+	double power_law_exponent = 2.5;
+	int band_width;
+	int planted_cover_size = 0;
+	double cost_correlation = 0;
+
+	ScpGeneratorSettings (
+		string mode, int n, int m, int max_cost, double density, int seed
+	) {
+		this->mode = mode;
+		this->n = n, this->m = m, this->max_cost = max_cost;
+		this->density = density, this->seed = seed;
+		band_width = max(1, n / 20);
+	}
+
+	// Approximate number of rows in a column, ignoring the rows added to
+	// guarantee that every row is covered
+	double expectedColumnSize () {
+		if (mode == "banded")
+			return density * (min(band_width, n) + 1) / 2;
+		return density * n;
+	}
+};
+
+/**
+ * @brief A small, seeded source of random numbers whose output does not depend
+ * on the standard library implementation, so that a seed reproduces the same
+ * instance on every platform.
+ */
+struct ScpRandom {
+	mt19937_64 engine;
+
+	explicit ScpRandom (int seed) : engine(seed) {}
+
+	// Uniform integer in [0, k)
+	long long nextInt (long long k) { return engine() % k; }
+	// Uniform real in (0, 1]
+	double nextUnit () { return ((engine() >> 11) + 1) * 0x1.0p-53; }
+	// Number of failures before the first success of a Bernoulli(p) process
+	long long nextGeometric (double p) {
+		if (p >= 1) return 0;
+		if (p <= 0) return LLONG_MAX / 4;
+		return (long long)(log(nextUnit()) / log1p(-p));
+	}
+};
+
+// Maximum number of windows tried when anchoring a row in banded mode
+const int kAnchorAttempts = 64;
+
+/**
+ * @brief Generates the columns of a structured SCP instance one at a time in
+ * order, so that instances far larger than memory allows can be streamed to a
+ * file. Apart from the columns currently being emitted, memory use is O(n + m).
+ *
+ * @param settings The generator settings (mode must not be bernoulli)
+ * @param emit Called as `emit(cost, rows)` for columns 0, ..., m - 1, where
+ * `rows` holds zero-indexed rows in ascending order
+ * @return long long The cost of the planted optimal cover, or -1 if none was
+ * planted
+ */
+long long generateScpColumns (
+	ScpGeneratorSettings &settings,
+	function<void (int, vector<int> &)> emit
+) {
+	int n = settings.n, m = settings.m;
+	ScpRandom random(settings.seed);
+	double expected_size = max(1.0, settings.expectedColumnSize());
+	auto nextCost = [&] (int size) {
+		double base = random.nextInt(settings.max_cost) + 1;
+		// In `double`, since max_cost × size overflows `int` for large columns
+		double proportional =
+			(double)settings.max_cost * size / (2 * expected_size);
+		double cost = (1 - settings.cost_correlation) * base +
+			settings.cost_correlation * proportional;
+		return (int)clamp(llround(cost), 1LL, (long long)INT_MAX);
+	};
+
+	// Banded mode: windows are laid out before generation so that rows can be
+	// anchored to a column whose window contains them
+	vector<int> window_starts, window_widths;
+	if (settings.mode == "banded") {
+		int width_limit = min(settings.band_width, n);
+		for (int c = 0; c < m; c++) {
+			int width = random.nextInt(width_limit) + 1;
+			window_starts.push_back(random.nextInt(n - width + 1));
+			window_widths.push_back(width);
+		}
+	}
+
+	// Planted cover: planted_block[c] holds the block of rows covered by
+	// column c if it is planted, and -1 otherwise
+	long long planted_optimum = -1;
+	int block_count = min({settings.planted_cover_size, n, m});
+	vector<int> planted_block, block_rows, block_starts, block_costs;
+	vector<double> row_shares; // row_shares[r] holds r's share of its block
+	if (block_count > 0) {
+		planted_optimum = 0;
+		planted_block.assign(m, -1);
+		for (int r = 0; r < n; r++) block_rows.push_back(r);
+		if (settings.mode != "banded") {
+			for (int i = n - 1; i > 0; i--)
+				swap(block_rows[i], block_rows[random.nextInt(i + 1)]);
+		}
+		for (int j = 0; j <= block_count; j++)
+			block_starts.push_back((long long)j * n / block_count);
+		// Selects block_count distinct columns with Floyd's algorithm
+		for (int c = m - block_count, j = 0; c < m; c++, j++) {
+			int pick = random.nextInt(c + 1);
+			planted_block[planted_block[pick] == -1 ? pick : c] = j;
+		}
+		row_shares.resize(n);
+		for (int j = 0; j < block_count; j++) {
+			int size = block_starts[j + 1] - block_starts[j];
+			block_costs.push_back(nextCost(size));
+			planted_optimum += block_costs[j];
+			for (int i = block_starts[j]; i < block_starts[j + 1]; i++)
+				row_shares[block_rows[i]] = (double)block_costs[j] / size;
+		}
+	}
+
+	// Without a planted cover, each row is anchored to one column so that
+	// every row is covered. anchor_rows[anchor_starts[c]...] holds the rows
+	// anchored to column c (sorted by counting).
+	vector<int> anchor_starts, anchor_rows;
+	if (block_count == 0) {
+		vector<int> anchors(n);
+		if (settings.mode == "banded") {
+			// Sorts columns by window start (by counting), so that the windows
+			// that can contain row r are the contiguous run of columns starting
+			// in [r - width_limit + 1, r]
+			int width_limit = min(settings.band_width, n);
+			vector<int> start_offsets(n + 1), by_start(m);
+			for (int start: window_starts) start_offsets[start + 1]++;
+			for (int r = 0; r < n; r++)
+				start_offsets[r + 1] += start_offsets[r];
+			vector<int> next_slot(start_offsets.begin(),
+				start_offsets.end() - 1);
+			for (int c = 0; c < m; c++)
+				by_start[next_slot[window_starts[c]]++] = c;
+			for (int r = 0; r < n; r++) {
+				int first = start_offsets[max(0, r - width_limit + 1)];
+				int last = start_offsets[r + 1];
+				if (first == last) {
+					anchors[r] = random.nextInt(m);
+					continue;
+				}
+				// Rejection sampling picks a uniformly random window containing
+				// r in O(1) expected attempts, since a window in the run
+				// contains r with probability about 1/2. If none is found, a
+				// window starting nearby is used.
+				anchors[r] = by_start[first + random.nextInt(last - first)];
+				for (int attempt = 0; attempt < kAnchorAttempts; attempt++) {
+					int c = by_start[first + random.nextInt(last - first)];
+					if (window_starts[c] + window_widths[c] > r) {
+						anchors[r] = c;
+						break;
+					}
+				}
+			}
+		} else {
+			for (int &c: anchors) c = random.nextInt(m);
+		}
+		anchor_starts.assign(m + 1, 0);
+		for (int c: anchors) anchor_starts[c + 1]++;
+		for (int c = 0; c < m; c++) anchor_starts[c + 1] += anchor_starts[c];
+		anchor_rows.resize(n);
+		vector<int> next_slot(anchor_starts.begin(), anchor_starts.end() - 1);
+		for (int r = 0; r < n; r++) anchor_rows[next_slot[anchors[r]]++] = r;
+	}
+
+	vector<int> rows;
+	vector<char> marked(n); // Scratch for sampling distinct rows
+	for (int c = 0; c < m; c++) {
+		rows.clear();
+		if (block_count > 0 && planted_block[c] != -1) {
+			int j = planted_block[c];
+			rows.assign(block_rows.begin() + block_starts[j],
+				block_rows.begin() + block_starts[j + 1]);
+			sort(rows.begin(), rows.end());
+			emit(block_costs[j], rows);
+			continue;
+		}
+
+		if (settings.mode == "power-law") {
+			double alpha = settings.power_law_exponent;
+			// Pareto minimum giving a mean of density * n when alpha > 2
+			double min_size = alpha > 2 ?
+				max(1.0, expected_size * (alpha - 2) / (alpha - 1)) : 1;
+			double size = min_size * pow(random.nextUnit(), -1 / (alpha - 1));
+			int s = min((double)n, max(1.0, floor(size)));
+			// Samples s distinct rows with Floyd's algorithm
+			for (int r = n - s; r < n; r++) {
+				int pick = random.nextInt(r + 1);
+				if (marked[pick]) pick = r;
+				marked[pick] = true;
+				rows.push_back(pick);
+			}
+			for (int r: rows) marked[r] = false;
+			sort(rows.begin(), rows.end());
+		} else {
+			int start = 0, end = n;
+			if (settings.mode == "banded") {
+				start = window_starts[c];
+				end = start + window_widths[c];
+			}
+			// Skips directly between filled cells in O(filled cells)
+			for (long long r = start + random.nextGeometric(settings.density);
+				r < end; r += 1 + random.nextGeometric(settings.density))
+				rows.push_back(r);
+		}
+
+		if (block_count == 0) {
+			int old_size = rows.size();
+			for (int i = anchor_starts[c]; i < anchor_starts[c + 1]; i++)
+				rows.push_back(anchor_rows[i]);
+			inplace_merge(rows.begin(), rows.begin() + old_size,
+				rows.end());
+			rows.erase(unique(rows.begin(), rows.end()), rows.end());
+		}
+
+		int cost = nextCost(rows.size());
+		if (block_count > 0) {
+			// Keeps the planted shares a feasible LP dual
+			double share_total = 0;
+			for (int r: rows) share_total += row_shares[r];
+			cost = max((long long)cost,
+				(long long)min(ceil(share_total - 1e-9), (double)INT_MAX));
+		}
+		emit(cost, rows);
+	}
+	return planted_optimum;
+}
+
+/**
+ * @brief Generates a SCP instance in memory using a structured generator mode.
+ *
+ * @param settings The generator settings
+ * @param planted_optimum Set to the cost of the planted optimal cover, or -1 if
+ * none was planted
+ * @return ScpInstance*
+ */
+unique_ptr<ScpInstance> generateScpInstance (
+	ScpGeneratorSettings &settings, long long &planted_optimum
+) {
+	ScpTraceSpan span("generate", settings.mode);
+	planted_optimum = -1;
+	if (settings.mode == "bernoulli") {
+		return generateScpInstance(settings.n, settings.m, settings.max_cost,
+			settings.density, settings.seed);
+	}
+	unique_ptr<ScpInstance> instance(new ScpInstance(settings.n, settings.m));
+	int c = 0;
+	planted_optimum = generateScpColumns(settings,
+		[&] (int cost, vector<int> &rows) {
+			instance->costs[c] = cost;
+			instance->columns[c] = rows;
+			for (int r: rows) instance->rows[r].push_back(c);
+			c++;
+		}
+	);
+	return instance;
+}
+
+/**
+ * @brief Generates a SCP instance and writes it directly to an input file in
+ * the "columns" format. Structured modes stream each column to the file as it
+ * is generated, without holding the instance in memory; Bernoulli instances
+ * are generated in memory first.
+ *
+ * @param settings The generator settings
+ * @param input_path The path to write the instance to
+ * @param planted_optimum Set to the cost of the planted optimal cover, or -1 if
+ * none was planted
+ * @return Whether the file was written
+ */
+bool streamScpInstance (
+	ScpGeneratorSettings &settings, string input_path, long long &planted_optimum
+) {
+	planted_optimum = -1;
+	ofstream fout;
+	vector<char> buffer(1 << 20);
+	fout.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+	fout.open(input_path);
+	if (!fout.is_open()) return false;
+	fout << settings.n << ' ' << settings.m << '\n';
+	auto writeColumn = [&] (int cost, vector<int> &rows) {
+		fout << cost << ' ' << rows.size();
+		for (int r: rows) fout << ' ' << r + 1;
+		fout << '\n';
+	};
+	if (settings.mode == "bernoulli") {
+		unique_ptr<ScpInstance> instance(
+			generateScpInstance(settings, planted_optimum)
+		);
+		for (int c = 0; c < instance->m; c++)
+			writeColumn(instance->costs[c], instance->columns[c]);
+	} else {
+		ScpTraceSpan span("generate", settings.mode);
+		planted_optimum = generateScpColumns(settings, writeColumn);
+	}
+	fout.close();
+	return !fout.fail();
+}
@@ -11,20 +11,38 @@
 #include <chrono> // For timing algorithms
 #include <cstdlib> // Imports `srand()` and `rand()`
 #include <sstream> // For `doubleToString()`
+#include <iomanip> // Imports `setprecision`
 #include <map> // For storing algorithm results
+#include <queue> // Imports `priority_queue`
+#include <mutex> // For recording trace spans from multiple threads
+#include <atomic>
 #include <ctime> // Imports `time_t`, `time`, and `ctime`
 #include <memory> // Imports `unique_ptr`
 #include <regex> // Imports `regex` and `regex_replace`
+#include <cstdint> // Fixed-width integers for binary results files
+#include <climits> // Imports `INT_MAX` and `LLONG_MAX`
+#include <cmath> // Imports `log`, `pow`, and `llround`
+#include <random> // Imports `mt19937_64` for the structured generators
+#include <functional> // Imports `function`
+#include <new> // Imports `bad_alloc` and `align_val_t`
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h> // Imports `mmap` and `madvise` for `ScpArena`
+#endif
 
 using std::filesystem::create_directory;
-using std::ifstream, std::ofstream;
-using std::cout, std::endl;
+using std::ifstream, std::ofstream, std::ostream;
+using std::cout, std::endl, std::fixed, std::setprecision;
 using std::string, std::ostringstream, std::to_string;
-using std::replace;
+using std::replace, std::find, std::max, std::min, std::swap, std::clamp;
+using std::inplace_merge, std::unique, std::remove_if, std::binary_search;
 using std::vector, std::map, std::pair;
-using std::chrono::system_clock, std::chrono::duration;
+using std::priority_queue, std::greater;
+using std::chrono::system_clock, std::chrono::steady_clock;
+using std::chrono::duration;
 using std::unique_ptr;
-using std::regex, std::regex_replace;
+using std::function;
+using std::mt19937_64;
+using std::regex, std::regex_replace, std::regex_match, std::smatch;
 
 /**
  * @brief Converts a `double` to a `string`.
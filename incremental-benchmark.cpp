@@ -0,0 +1,150 @@
+/**
+ * @file incremental-benchmark.cpp
+ * @brief This is the entry file for a benchmark comparing
+ * `IncrementalScpSolver` with re-solving from scratch with OG after each batch
+ * of random updates. Compile it separately, for example:
+ * `g++ -std=gnu++17 -O2 incremental-benchmark.cpp -o incremental-benchmark`.
+ *
+ * Usage:
+ * ```
+ * ./incremental-benchmark [n] [m] [density] [batches] [changes per batch]
+ * ```
+ * Each batch changes the costs of, inserts, and retires the given number of
+ * random columns; inserted columns have between 1 and about 2 × density × n
+ * rows. n, m, density, and the number of batches must be positive. After
+ * every batch the cover is checked against a separate copy of the instance,
+ * and averages are printed as a tab-separated table. The exit code is 1 if
+ * the arguments are invalid or any cover is.
+ */
+#include "header.cpp"
+#include "trace.cpp"
+#include "generator.cpp"
+#include "allocator.cpp"
+#include "solver.cpp"
+#include "incremental.cpp"
+
+const int kMaxCost = 1000;
+
+int main (int argc, char *argv[]) {
+	int n = argc > 1 ? atoi(argv[1]) : 2000;
+	int m = argc > 2 ? atoi(argv[2]) : 20000;
+	double density = argc > 3 ? atof(argv[3]) : 0.005;
+	int batch_count = argc > 4 ? atoi(argv[4]) : 100;
+	int changes_per_batch = argc > 5 ? atoi(argv[5]) : 10;
+	if (n < 1 || m < 1 || density <= 0 || batch_count < 1 ||
+		changes_per_batch < 0) {
+		std::cerr << "Error: n, m, density, and batches must be positive, " <<
+			"and changes per batch non-negative" << endl;
+		return 1;
+	}
+	// Inserted columns have at least one row, even when density × n < 0.5
+	long long max_inserted_size = max(1LL, (long long)(2 * density * n));
+
+	ofstream log_file("incremental-benchmark-log.txt");
+	cout << currentTimeMargin() << "Generating power-law " << n << " × " <<
+		m << " instance with density " << density << "..." << endl;
+	ScpGeneratorSettings settings("power-law", n, m, kMaxCost, density, 1);
+	long long planted_optimum;
+	unique_ptr<ScpInstance> input(
+		generateScpInstance(settings, planted_optimum)
+	);
+	IncrementalScpSolver solver(input, log_file);
+	solver.solve();
+
+	// `input` is kept in step with the solver's instance, with retired
+	// columns emptied, so that covers can be checked and re-solved from it
+	ScpRandom random(2);
+	vector<bool> live(m, true);
+	int violation_count = 0;
+	int scratch_count = 0;
+	double incremental_runtime = 0, scratch_runtime = 0;
+	long long incremental_total = 0, scratch_total = 0;
+	for (int batch_index = 0; batch_index < batch_count; batch_index++) {
+		ScpUpdateBatch batch;
+		for (int i = 0; i < changes_per_batch; i++) {
+			int c = random.nextInt(input->m);
+			if (!live[c]) continue;
+			live[c] = false;
+			batch.retirements.push_back(c);
+		}
+		for (int i = 0; i < changes_per_batch; i++) {
+			int c = random.nextInt(input->m);
+			int cost = random.nextInt(kMaxCost) + 1;
+			if (live[c]) batch.cost_changes.push_back({c, cost});
+		}
+		for (int i = 0; i < changes_per_batch; i++) {
+			vector<int> column;
+			int size = random.nextInt(max_inserted_size) + 1;
+			for (int j = 0; j < size; j++) column.push_back(random.nextInt(n));
+			sort(column.begin(), column.end());
+			column.erase(unique(column.begin(), column.end()), column.end());
+			batch.insertions.push_back({(int)random.nextInt(kMaxCost) + 1,
+				column});
+		}
+
+		// Mirrors the batch in `input`
+		for (int c: batch.retirements) {
+			for (int r: input->columns[c]) {
+				vector<int> &row = input->rows[r];
+				row.erase(find(row.begin(), row.end(), c));
+			}
+			input->columns[c].clear();
+		}
+		for (pair<int, int> change: batch.cost_changes)
+			input->costs[change.first] = change.second;
+		for (pair<int, vector<int>> &insertion: batch.insertions) {
+			for (int r: insertion.second) input->rows[r].push_back(input->m);
+			input->columns.push_back(insertion.second);
+			input->costs.push_back(insertion.first);
+			live.push_back(true);
+			input->m++;
+		}
+
+		vector<int> inserted;
+		bool feasible = solver.applyUpdates(batch, inserted);
+		unique_ptr<ScpSolution> solution(solver.getSolution());
+		incremental_runtime += solution->runtime;
+		incremental_total += solution->total_cost;
+
+		// Checks that the cover is valid and its total cost is correct
+		vector<bool> covered(n);
+		long long total_cost = 0;
+		bool ok = true;
+		for (int c: solution->selected) {
+			ok &= live[c - 1];
+			total_cost += input->costs[c - 1];
+			for (int r: input->columns[c - 1]) covered[r] = true;
+		}
+		bool coverable = true;
+		for (int r = 0; r < n; r++) {
+			coverable &= !input->rows[r].empty();
+			ok &= covered[r] || input->rows[r].empty();
+		}
+		ok &= total_cost == solution->total_cost && feasible == coverable;
+		if (!ok) {
+			violation_count++;
+			cout << currentTimeMargin() << "Error: Invalid cover after batch " <<
+				batch_index + 1 << endl;
+		}
+
+		// OG cannot solve instances with uncoverable rows
+		if (!coverable) continue;
+		unique_ptr<ScpSolution> scratch(
+			solveScpInstance(input, "OG", log_file)
+		);
+		scratch_count++;
+		scratch_runtime += scratch->runtime;
+		scratch_total += scratch->total_cost;
+	}
+
+	cout << "Method\tRuntime (s)\tTotal cost" << endl;
+	cout << "Incremental\t" << incremental_runtime / batch_count << '\t' <<
+		(double)incremental_total / batch_count << endl;
+	if (scratch_count) {
+		cout << kAlgorithms.at("OG") << '\t' << scratch_runtime / scratch_count <<
+			'\t' << (double)scratch_total / scratch_count << endl;
+	}
+	cout << "Invalid covers: " << violation_count << '/' << batch_count << endl;
+	log_file.close();
+	return violation_count ? 1 : 0;
+}
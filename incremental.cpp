@@ -0,0 +1,333 @@
+/**
+ * @file incremental.cpp
+ * @brief This file contains a solver that keeps an optimized-greedy solution
+ * to an SCP instance up to date as column costs change and columns are added
+ * or retired, without re-solving from scratch.
+ */
+
+/**
+ * @brief A batch of changes to the instance of an `IncrementalScpSolver`.
+ * Columns and rows are zero-indexed, as in `ScpInstance`.
+ */
+struct ScpUpdateBatch {
+	vector<pair<int, int>> cost_changes; // (column, new cost)
+	vector<pair<int, vector<int>>> insertions; // (cost, rows) of new columns
+	vector<int> retirements; // Columns to delete
+};
+
+/**
+ * @brief Keeps the state of optimized greedy (OG) for an instance between
+ * batches of updates, and repairs the cover locally after each batch.
+ *
+ * A batch is applied in three steps:
+ * 1. Selected columns that are retired or become more expensive are dropped
+ *    from the cover, uncovering the rows that no other selected column covers.
+ * 2. The uncovered rows are covered again with OG restricted to the columns
+ *    containing them.
+ * 3. Inserted and cheaper columns are offered to the cover: each one is added
+ *    if the selected columns it makes redundant cost more than it does.
+ *    Selected columns near the changes that have become redundant are pruned.
+ *
+ * Each step only visits the changed columns, the rows they contain, and the
+ * columns containing those rows, so a small batch costs far less than the
+ * ∑|S_i| of a full solve.
+ *
+ * Local repairs can drift from what a full solve would find after many
+ * batches; calling `solve()` again starts over from the current instance.
+ *
+ * Retired columns keep their index (inserted columns receive new indices) and
+ * are removed lazily from `rows` the next time each row is visited.
+ */
+class IncrementalScpSolver {
+ public:
+	IncrementalScpSolver (unique_ptr<ScpInstance> &input, ofstream &log_file) :
+		log_file(log_file) {
+		n = input->n;
+		costs = input->costs;
+		rows = input->rows, columns = input->columns;
+		int m = input->m;
+		column_sizes.assign(m, 0);
+		selected.assign(m, false), retired.assign(m, false);
+		cover_counts.assign(n, 0);
+	}
+
+	/**
+	 * @brief Solves the instance from scratch with OG, then prunes redundant
+	 * columns.
+	 *
+	 * @return Whether every row could be covered
+	 */
+	bool solve () {
+		ScpTraceSpan span("incremental-solve");
+		auto start_time = system_clock::now();
+		for (int c = 0; c < columns.size(); c++)
+			if (selected[c]) deselectColumn(c);
+		vector<int> uncovered;
+		for (int r = 0; r < n; r++) uncovered.push_back(r);
+		vector<int> newly_selected;
+		coverRows(uncovered, newly_selected);
+		pruneRedundant(newly_selected);
+		duration<double> elapsed = system_clock::now() - start_time;
+		runtime = elapsed.count();
+		return uncovered_rows.empty();
+	}
+
+	/**
+	 * @brief Applies a batch of updates and repairs the cover.
+	 *
+	 * @param batch The updates to apply
+	 * @param inserted Set to the indices given to the inserted columns, in
+	 * order
+	 * @return Whether every row is covered, including rows left uncovered by
+	 * earlier batches
+	 */
+	bool applyUpdates (ScpUpdateBatch &batch, vector<int> &inserted) {
+		ScpTraceSpan span("incremental-update");
+		auto start_time = system_clock::now();
+		vector<int> uncovered, offered;
+
+		for (int c: batch.retirements) {
+			if (!isLiveColumn(c)) continue;
+			if (selected[c]) {
+				for (int r: deselectColumn(c)) uncovered.push_back(r);
+			}
+			retired[c] = true;
+			vector<int>().swap(columns[c]);
+		}
+
+		for (pair<int, int> change: batch.cost_changes) {
+			int c = change.first, cost = change.second;
+			if (!isLiveColumn(c)) continue;
+			if (selected[c] && cost > costs[c]) {
+				// It may be selected again by the repair at its new cost
+				for (int r: deselectColumn(c)) uncovered.push_back(r);
+			} else if (selected[c]) {
+				total_cost += cost - costs[c];
+			} else if (cost < costs[c]) {
+				offered.push_back(c);
+			}
+			costs[c] = cost;
+		}
+
+		inserted.clear();
+		for (pair<int, vector<int>> &insertion: batch.insertions) {
+			int c = columns.size();
+			vector<int> column;
+			sort(insertion.second.begin(), insertion.second.end());
+			insertion.second.erase(unique(insertion.second.begin(),
+				insertion.second.end()), insertion.second.end());
+			for (int r: insertion.second) {
+				if (r < 0 || r >= n) {
+					log_file << currentTimeMargin() << "Error: Row " << r <<
+						" of inserted column " << c << " is out of range\n";
+					continue;
+				}
+				column.push_back(r);
+				rows[r].push_back(c);
+			}
+			costs.push_back(insertion.first);
+			columns.push_back(column);
+			column_sizes.push_back(0);
+			selected.push_back(false), retired.push_back(false);
+			inserted.push_back(c);
+			offered.push_back(c);
+		}
+
+		// Rows left uncovered by earlier batches may be covered by the inserted
+		// columns
+		uncovered.insert(uncovered.end(), uncovered_rows.begin(),
+			uncovered_rows.end());
+		sort(uncovered.begin(), uncovered.end());
+		uncovered.erase(unique(uncovered.begin(), uncovered.end()),
+			uncovered.end());
+		vector<int> newly_selected;
+		coverRows(uncovered, newly_selected);
+		for (int c: offered) offerColumn(c, newly_selected);
+		pruneRedundant(newly_selected);
+
+		duration<double> elapsed = system_clock::now() - start_time;
+		runtime = elapsed.count();
+		return uncovered_rows.empty();
+	}
+
+	/**
+	 * @brief Returns the current cover, with the runtime of the last call to
+	 * `solve` or `applyUpdates`.
+	 *
+	 * @return ScpSolution* The solution, with 1-indexed columns in order
+	 */
+	unique_ptr<ScpSolution> getSolution () {
+		unique_ptr<ScpSolution> solution(new ScpSolution());
+		for (int c = 0; c < columns.size(); c++)
+			if (selected[c]) solution->selected.push_back(c + 1);
+		solution->total_cost = total_cost;
+		solution->runtime = runtime;
+		return solution;
+	}
+
+ private:
+	int n;
+	vector<int> costs;
+	vector<vector<int>> rows, columns;
+	/*
+	 * column_sizes[c] holds the number of uncovered rows in column c, as in
+	 * OG. It is only non-zero while `coverRows` runs.
+	 */
+	vector<int> column_sizes;
+	vector<bool> selected, retired;
+	vector<int> cover_counts; // cover_counts[r] holds # selected columns with r
+	vector<int> uncovered_rows; // Rows no live column contains, in order
+	long long total_cost = 0;
+	double runtime = 0;
+	ofstream &log_file;
+
+	bool isLiveColumn (int c) {
+		if (c >= 0 && c < columns.size() && !retired[c]) return true;
+		log_file << currentTimeMargin() << "Error: Column " << c <<
+			" does not exist\n";
+		return false;
+	}
+
+	// Removes retired columns from rows[r].
+	void compactRow (int r) {
+		vector<int> &row = rows[r];
+		row.erase(remove_if(row.begin(), row.end(),
+			[&] (int c) { return retired[c]; }), row.end());
+	}
+
+	void selectColumn (int c) {
+		selected[c] = true;
+		total_cost += costs[c];
+		for (int r: columns[c]) {
+			if (cover_counts[r]++) continue;
+			// Performs updates on all newly-covered elements
+			for (int other: rows[r]) column_sizes[other]--;
+		}
+	}
+
+	// Returns the rows left uncovered by removing c from the cover.
+	vector<int> deselectColumn (int c) {
+		vector<int> uncovered;
+		selected[c] = false;
+		total_cost -= costs[c];
+		for (int r: columns[c])
+			if (!--cover_counts[r]) uncovered.push_back(r);
+		return uncovered;
+	}
+
+	/**
+	 * @brief Covers the given rows with OG, choosing only among the columns
+	 * containing them. A heap replaces OG's scan over all columns so that each
+	 * choice costs O(log(# candidate columns)). Rows that no live column
+	 * contains are left in `uncovered_rows`.
+	 *
+	 * @param uncovered The rows to cover, in ascending order
+	 */
+	void coverRows (vector<int> &uncovered, vector<int> &newly_selected) {
+		vector<int> previously_uncovered;
+		previously_uncovered.swap(uncovered_rows);
+		// Heap of (unit cost, column); entries go stale as sizes shrink
+		priority_queue<pair<double, int>, vector<pair<double, int>>,
+			greater<pair<double, int>>> heap;
+		for (int r: uncovered) {
+			compactRow(r);
+			if (rows[r].empty()) {
+				// Logs each row only when it first becomes uncoverable
+				if (!binary_search(previously_uncovered.begin(),
+					previously_uncovered.end(), r)) {
+					log_file << currentTimeMargin() <<
+						"Error: No set contains element " << r + 1 << '\n';
+				}
+				uncovered_rows.push_back(r);
+			}
+			for (int c: rows[r]) column_sizes[c]++;
+		}
+		for (int r: uncovered) {
+			for (int c: rows[r]) {
+				heap.push({double(costs[c]) / column_sizes[c], c});
+			}
+		}
+		while (!heap.empty()) {
+			pair<double, int> top = heap.top();
+			heap.pop();
+			int c = top.second;
+			if (!column_sizes[c] || selected[c]) continue;
+			double unit_cost = double(costs[c]) / column_sizes[c];
+			if (unit_cost > top.first) {
+				heap.push({unit_cost, c});
+				continue;
+			}
+			selectColumn(c);
+			newly_selected.push_back(c);
+		}
+	}
+
+	/**
+	 * @brief Adds column c to the cover if the selected columns it makes
+	 * redundant cost more than it does.
+	 */
+	void offerColumn (int c, vector<int> &newly_selected) {
+		if (selected[c] || retired[c]) return;
+		selectColumn(c);
+		vector<int> removed;
+		long long removed_cost = 0;
+		for (int other: findRedundant(c)) {
+			if (!isRedundant(other)) continue;
+			deselectColumn(other);
+			removed.push_back(other);
+			removed_cost += costs[other];
+		}
+		if (removed_cost > costs[c]) {
+			newly_selected.push_back(c);
+			return;
+		}
+		for (int other: removed) selectColumn(other);
+		deselectColumn(c);
+	}
+
+	// Prunes selected columns that overlap the given columns and are
+	// redundant, most expensive first.
+	void pruneRedundant (vector<int> &changed) {
+		vector<int> candidates;
+		for (int c: changed) {
+			vector<int> redundant = findRedundant(c);
+			candidates.insert(candidates.end(), redundant.begin(),
+				redundant.end());
+			if (selected[c]) candidates.push_back(c);
+		}
+		sort(candidates.begin(), candidates.end(), [&] (int a, int b) {
+			return costs[a] != costs[b] ? costs[a] > costs[b] : a < b;
+		});
+		candidates.erase(unique(candidates.begin(), candidates.end()),
+			candidates.end());
+		for (int c: candidates)
+			if (selected[c] && isRedundant(c)) deselectColumn(c);
+	}
+
+	// Returns the selected columns other than c that share a row with c, are
+	// redundant, and are sorted by decreasing cost.
+	vector<int> findRedundant (int c) {
+		vector<int> redundant;
+		for (int r: columns[c]) {
+			if (cover_counts[r] < 2) continue;
+			compactRow(r);
+			for (int other: rows[r]) {
+				if (other != c && selected[other] && isRedundant(other))
+					redundant.push_back(other);
+			}
+		}
+		sort(redundant.begin(), redundant.end(), [&] (int a, int b) {
+			return costs[a] != costs[b] ? costs[a] > costs[b] : a < b;
+		});
+		redundant.erase(unique(redundant.begin(), redundant.end()),
+			redundant.end());
+		return redundant;
+	}
+
+	// Whether every row of selected column c is covered by another column
+	bool isRedundant (int c) {
+		for (int r: columns[c])
+			if (cover_counts[r] < 2) return false;
+		return true;
+	}
+};
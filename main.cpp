@@ -4,8 +4,11 @@
  * collects data at a variety of settings.
  */
 #include "header.cpp"
+#include "trace.cpp"
 #include "generator.cpp"
+#include "allocator.cpp"
 #include "solver.cpp"
+#include "results.cpp"
 
 // SCP instances (input data sets) are located in `kInputDirectory`. Random
 // instances generated by this program will be written to there.
@@ -76,11 +79,28 @@ const vector<double> kDensities = {
 	0.99
 };
 const int kMaxCost = 1000;
+/**
+ * Generator modes (see `ScpGeneratorSettings`)
+ * bernoulli: The original generator (uniform density, row by row)
+ * uniform: Uniform density, sampled column by column
+ * power-law: Power-law column sizes with mean `density * n`
+ * banded: Windows of consecutive rows resembling crew-scheduling rails
+ */
+const string kGeneratorMode = "bernoulli";
+// Number of columns in a planted optimal cover (0 for none; ignored by
+// bernoulli). A planted optimum allows approximation ratios at any size.
+const int kPlantedCoverSize = 0;
+// Correlation of column costs with column sizes (0 to 1; ignored by bernoulli)
+const double kCostCorrelation = 0;
+const bool kPlanted = kGeneratorMode != "bernoulli" && kPlantedCoverSize > 0;
 // Number of repetitions run per experimental condition
 const int kTrialsPerCondition = 5;
 const int kTotalTrials = kSizes.size() * kDensities.size() *
 	kTrialsPerCondition;
 const bool kWriteInput = false;
+// Solutions are always appended to the run's results file; this additionally
+// writes each one to its own text file
+const bool kWriteSolutionFiles = false;
 
 int main () {
 	string run_output_directory = kOutputDirectory + getCurrentTimeString() +
@@ -104,6 +124,11 @@ int main () {
 	for (double density: kDensities) log_file << density << ' ';
 	log_file << endl;
 	log_file << currentTimeMargin() << "Max column cost: " << kMaxCost << endl;
+	log_file << currentTimeMargin() << "Generator mode: " << kGeneratorMode;
+	if (kPlanted) log_file << ", planted cover size " << kPlantedCoverSize;
+	if (kGeneratorMode != "bernoulli")
+		log_file << ", cost correlation " << kCostCorrelation;
+	log_file << endl;
 	log_file << currentTimeMargin() << "Trials per experimental condition: " <<
 		kTrialsPerCondition << endl;
 	log_file << currentTimeMargin() << endl;
@@ -114,8 +139,39 @@ int main () {
 		run_output_directory << endl;
 	log_file << currentTimeMargin() << "Input writing is " <<
 		(kWriteInput ? "on" : "off") << endl;
+	log_file << currentTimeMargin() << "Solution file writing is " <<
+		(kWriteSolutionFiles ? "on" : "off") << endl;
+
+	// The allocation mode is selected at runtime with the `SCP_ALLOCATOR`
+	// environment variable (see `kAllocationModes`)
+	string allocation_mode = "default";
+	if (getenv("SCP_ALLOCATOR")) allocation_mode = getenv("SCP_ALLOCATOR");
+	if (find(kAllocationModes.begin(), kAllocationModes.end(),
+		allocation_mode) == kAllocationModes.end()) {
+		log_file << currentTimeMargin() << "Error: Unsupported allocation " <<
+			"mode \"" << allocation_mode << "\", using default" << endl;
+		allocation_mode = "default";
+	}
+	unique_ptr<ScpArena> arena = createScpArena(allocation_mode);
+	log_file << currentTimeMargin() << "Allocation mode: " << allocation_mode <<
+		endl;
+	// Tracing is enabled at runtime with the `SCP_TRACE` environment variable
+	log_file << currentTimeMargin() << "Tracing is " <<
+		(scp_tracer.enabled ? "on" : "off") << endl;
 	log_file << currentTimeMargin() << endl;
 
+	// All solutions of this run are appended to a single results file, which
+	// `results-query` can export or summarize. It may be the only record of
+	// the solutions, so the run stops if it cannot be written
+	string results_path = run_output_directory + "results.scpr";
+	ScpResultsSink results(results_path);
+	if (!results.good()) {
+		log_file << currentTimeMargin() << "Error: Could not open " <<
+			results_path << endl;
+		cout << "Error: Could not open " << results_path << endl;
+		return 1;
+	}
+
 	// Runs and times all trials
 	auto start_time = system_clock::now();
 	int trial_count = 0, condition_count = 0;
@@ -164,50 +220,94 @@ int main () {
 				log_file << ", " << density << " density";
 				log_file << ", repetition #" << trial << '/' <<
 					kTrialsPerCondition << endl;
-				string data_set_name = "rand-" + kInputFormat +
-					'-' + size_string +
+				string data_set_name = "rand-";
+				if (kGeneratorMode != "bernoulli")
+					data_set_name += kGeneratorMode + '-';
+				if (kPlanted)
+					data_set_name += "P" + to_string(kPlantedCoverSize) + '-';
+				data_set_name += kInputFormat + '-' + size_string +
 					"-MC" + to_string(kMaxCost) +
 					"-D" + doubleToString(density) +
 					"-S" + to_string(trial);
 				log_file << currentTimeMargin() <<
 					"      Generating instance " << data_set_name << "..." <<
 					endl;
-				unique_ptr<ScpInstance> input(generateScpInstance(
+				ScpGeneratorSettings settings(
+					kGeneratorMode,
 					n,
 					m,
 					kMaxCost,
 					density,
 					trial
-				));
-				if (kWriteInput) {
-					writeScpInstance(input, kInputFormat,
-						kInputDirectory + data_set_name + ".txt");
+				);
+				settings.planted_cover_size = kPlantedCoverSize;
+				settings.cost_correlation = kCostCorrelation;
+				// `planted_optimum` is -1 if no optimal cover was planted
+				long long planted_optimum;
+				unique_ptr<ScpInstance> input;
+				string input_path = kInputDirectory + data_set_name + ".txt";
+				// Structured instances are streamed to the input file as they
+				// are generated, then read back to be solved
+				bool stream_input = kWriteInput &&
+					kGeneratorMode != "bernoulli" && kInputFormat == "columns";
+				if (stream_input) {
+					if (streamScpInstance(settings, input_path,
+						planted_optimum)) {
+						input = readScpInstance(input_path, kInputFormat,
+							log_file);
+					} else {
+						log_file << currentTimeMargin() <<
+							"      Error: Could not write " << input_path << endl;
+					}
+				}
+				if (!input) {
+					input = generateScpInstance(settings, planted_optimum);
+					if (kWriteInput && !stream_input)
+						writeScpInstance(input, kInputFormat, input_path);
 				}
 				// `exact_total` is -1 if there is no feasible exact algorithm
-				long long exact_total = -1;
+				// and no planted optimum
+				long long exact_total = planted_optimum;
 				for (string algorithm_id: size_algorithm_ids) {
 					log_file << currentTimeMargin() << "      Running " <<
 						algorithm_id << "...";
 					unique_ptr<ScpSolution> solution(
-						solveScpInstance(input, algorithm_id, log_file)
+						solveScpInstance(input, algorithm_id, log_file,
+							arena.get())
 					);
 					if (algorithm_id.back() == 'E')
 						exact_total = solution->total_cost;
 					data_collections[algorithm_id]->
 						recordTrial(solution, exact_total);
-					writeScpSolution(solution, run_output_directory +
-						data_set_name + '-' + algorithm_id + ".txt");
+					ScpTraceSpan record_span("record", algorithm_id);
+					results.append(data_set_name, algorithm_id, solution,
+						planted_optimum);
+					if (!results.good()) {
+						log_file << endl << currentTimeMargin() <<
+							"Error: Could not write to " << results_path << endl;
+						cout << "Error: Could not write to " << results_path <<
+							endl;
+						return 1;
+					}
+					if (kWriteSolutionFiles) {
+						writeScpSolution(solution, run_output_directory +
+							data_set_name + '-' + algorithm_id + ".txt");
+					}
+					record_span.end();
 					log_file << " (" << solution->runtime << " s)" << endl;
 				}
 			}
+			ScpTraceSpan averages_span("aggregate", size_string);
 			for (string algorithm_id: size_algorithm_ids) {
 				size_averages[algorithm_id].push_back(
 					data_collections[algorithm_id]->getAverages()
 				);
 			}
 		}
+		ScpTraceSpan stats_span("write-stats", size_string);
 		for (string stat_id: kAlgorithmStatsIds) {
-			if (stat_id == "AR" && size_algorithm_ids.front().back() != 'E')
+			if (stat_id == "AR" && size_algorithm_ids.front().back() != 'E' &&
+				!kPlanted)
 				continue;
 			string stats_file_name = "rand-" + size_string + "-MC" +
 				to_string(kMaxCost) + "-D";
@@ -249,6 +349,16 @@ int main () {
 		}
 	}
 	
+	if (!results.close()) {
+		log_file << currentTimeMargin() << "Error: Could not write to " <<
+			results_path << endl;
+		cout << "Error: Could not write to " << results_path << endl;
+	}
+	if (scp_tracer.enabled) {
+		log_file << currentTimeMargin() << "Writing trace.json..." << endl;
+		scp_tracer.writeChromeTrace(run_output_directory + "trace.json");
+	}
+
 	auto end_time = system_clock::now();
 	duration<double> elapsed = end_time - start_time;
 	double total_runtime = elapsed.count();
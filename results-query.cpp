@@ -0,0 +1,59 @@
+/**
+ * @file results-query.cpp
+ * @brief This is the entry file for a small tool that queries the results file
+ * written by `main.cpp`. Compile it separately, for example:
+ * `g++ -std=gnu++17 results-query.cpp -o results-query`.
+ *
+ * Usage:
+ * ```
+ * ./results-query [results path] csv [output path]
+ * ./results-query [results path] tsv [output path]
+ * ./results-query [results path] stats [output directory]
+ * ```
+ * `csv` and `tsv` print to standard output when no output path is given.
+ * `stats` rebuilds the statistics files, by default next to the results file.
+ */
+#include "header.cpp"
+#include "trace.cpp"
+#include "results.cpp"
+
+int main (int argc, char *argv[]) {
+	if (argc < 3) {
+		std::cerr << "Usage: " << argv[0] <<
+			" [results path] (csv|tsv|stats) [output path]" << endl;
+		return 1;
+	}
+	string results_path = argv[1], command = argv[2];
+	vector<ScpResultRecord> records = readScpResults(results_path, std::cerr);
+	if (records.empty()) {
+		std::cerr << "Error: " << results_path << " contains no records" <<
+			endl;
+		return 1;
+	}
+
+	if (command == "csv" || command == "tsv") {
+		char delimiter = command == "csv" ? ',' : '\t';
+		if (argc > 3) {
+			ofstream fout(argv[3]);
+			writeScpResultsDelimited(records, fout, delimiter);
+			fout.close();
+		} else {
+			writeScpResultsDelimited(records, cout, delimiter);
+		}
+	} else if (command == "stats") {
+		string output_directory;
+		if (argc > 3) {
+			output_directory = argv[3];
+			if (output_directory.back() != '/') output_directory += '/';
+		} else {
+			size_t slash = results_path.find_last_of('/');
+			if (slash != string::npos)
+				output_directory = results_path.substr(0, slash + 1);
+		}
+		writeScpStatsTables(records, output_directory, cout);
+	} else {
+		std::cerr << "Error: Unsupported command \"" << command << "\"" << endl;
+		return 1;
+	}
+	return 0;
+}
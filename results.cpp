@@ -0,0 +1,399 @@
+/**
+ * @file results.cpp
+ * @brief This file contains a sink that appends SCP solutions to a single
+ * buffered, columnar results file, along with functions for reading the file
+ * back and exporting it as delimited text or statistics tables.
+ *
+ * Results file layout (all integers are little-endian, as written by x86):
+ * ```
+ * "SCPRES02"                                  (8-byte file magic)
+ * // For each block of up to `kResultsBlockSize` records:
+ * [block marker] (uint32, `kResultsBlockMarker`)
+ * [record count] [key bytes] [algorithm bytes] [selected count]   (uint32)
+ * [key lengths]        (uint32 × record count)  [keys]        (chars)
+ * [algorithm lengths]  (uint32 × record count)  [algorithms]  (chars)
+ * [total costs]        (int64 × record count)
+ * [reference totals]   (int64 × record count, -1 if unknown)
+ * [runtimes]           (double × record count)
+ * [selected lengths]   (uint32 × record count)  [selected]    (int32)
+ * // Index, written when the sink is closed:
+ * // For each block: [block offset] (uint64) [record count] (uint32)
+ * [block count] (uint64) [index offset] (uint64) "SCPIDX01"
+ * ```
+ * If a run is interrupted before the index is written, the blocks flushed so
+ * far can still be recovered by scanning the file from the start.
+ */
+
+const string kResultsFileMagic = "SCPRES02";
+const string kResultsIndexMagic = "SCPIDX01";
+const uint32_t kResultsBlockMarker = 0x4b4c4253; // "SBLK"
+// Number of records buffered in memory before a block is flushed to disk
+const int kResultsBlockSize = 4096;
+
+/**
+ * @brief Represents a single row of a results file: one solution produced by
+ * one algorithm on one instance.
+ */
+struct ScpResultRecord {
+	string instance_key, algorithm_id;
+	long long total_cost;
+	// Known optimal total cost of the instance (such as a planted optimum), or
+	// -1 if unknown
+	long long reference_total;
+	double runtime;
+	vector<int> selected;
+};
+
+template <typename T>
+void writeBinary (ofstream &fout, const T *data, size_t count) {
+	fout.write(reinterpret_cast<const char *>(data), sizeof(T) * count);
+}
+
+template <typename T>
+bool readBinary (ifstream &fin, T *data, size_t count) {
+	fin.read(reinterpret_cast<char *>(data), sizeof(T) * count);
+	return (size_t)fin.gcount() == sizeof(T) * count;
+}
+
+/**
+ * @brief Appends SCP solutions to a results file, buffering each column in
+ * memory and flushing them together as a block once `kResultsBlockSize`
+ * records have accumulated.
+ */
+class ScpResultsSink {
+ public:
+	explicit ScpResultsSink (string results_path) {
+		fout.open(results_path, std::ios::binary);
+		fout.write(kResultsFileMagic.data(), kResultsFileMagic.size());
+		fout.flush();
+		ok = fout.good();
+	}
+	~ScpResultsSink () { close(); }
+
+	// Whether the file was opened and every block so far was written
+	bool good () { return ok; }
+
+	// Buffers a solution; `selected` is stored as given (1-indexed).
+	void append (
+		string instance_key, string algorithm_id,
+		unique_ptr<ScpSolution> &solution, long long reference_total = -1
+	) {
+		key_lengths.push_back(instance_key.size());
+		keys += instance_key;
+		algorithm_lengths.push_back(algorithm_id.size());
+		algorithms += algorithm_id;
+		total_costs.push_back(solution->total_cost);
+		reference_totals.push_back(reference_total);
+		runtimes.push_back(solution->runtime);
+		selected_lengths.push_back(solution->selected.size());
+		selected.insert(selected.end(), solution->selected.begin(),
+			solution->selected.end());
+		if (total_costs.size() >= kResultsBlockSize) flush();
+	}
+
+	// Writes all buffered records to disk as a new block, returning `good()`.
+	bool flush () {
+		if (total_costs.empty() || !fout.is_open()) return ok;
+		ScpTraceSpan span("write-results");
+		uint32_t record_count = total_costs.size();
+		block_offsets.push_back(fout.tellp());
+		block_record_counts.push_back(record_count);
+		uint32_t counts[5] = {
+			kResultsBlockMarker, record_count, (uint32_t)keys.size(),
+			(uint32_t)algorithms.size(), (uint32_t)selected.size()
+		};
+		writeBinary(fout, counts, 5);
+		writeBinary(fout, key_lengths.data(), record_count);
+		writeBinary(fout, keys.data(), keys.size());
+		writeBinary(fout, algorithm_lengths.data(), record_count);
+		writeBinary(fout, algorithms.data(), algorithms.size());
+		writeBinary(fout, total_costs.data(), record_count);
+		writeBinary(fout, reference_totals.data(), record_count);
+		writeBinary(fout, runtimes.data(), record_count);
+		writeBinary(fout, selected_lengths.data(), record_count);
+		writeBinary(fout, selected.data(), selected.size());
+		fout.flush();
+		ok &= fout.good();
+		key_lengths.clear(), algorithm_lengths.clear();
+		keys.clear(), algorithms.clear();
+		total_costs.clear(), reference_totals.clear(), runtimes.clear();
+		selected_lengths.clear(), selected.clear();
+		return ok;
+	}
+
+	// Flushes the last block and writes the index, returning `good()`. Safe to
+	// call repeatedly.
+	bool close () {
+		if (!fout.is_open()) return ok;
+		flush();
+		uint64_t index_offset = fout.tellp();
+		for (int i = 0; i < block_offsets.size(); i++) {
+			writeBinary(fout, &block_offsets[i], 1);
+			writeBinary(fout, &block_record_counts[i], 1);
+		}
+		uint64_t block_count = block_offsets.size();
+		writeBinary(fout, &block_count, 1);
+		writeBinary(fout, &index_offset, 1);
+		fout.write(kResultsIndexMagic.data(), kResultsIndexMagic.size());
+		fout.close();
+		ok &= !fout.fail();
+		return ok;
+	}
+
+ private:
+	ofstream fout;
+	bool ok;
+	// Buffered columns of the current block
+	vector<uint32_t> key_lengths, algorithm_lengths, selected_lengths;
+	string keys, algorithms;
+	vector<int64_t> total_costs, reference_totals;
+	vector<double> runtimes;
+	vector<int32_t> selected;
+	// Index of the blocks written so far
+	vector<uint64_t> block_offsets;
+	vector<uint32_t> block_record_counts;
+};
+
+/**
+ * @brief Reads the block starting at the current position of `fin` and
+ * appends its records to `records`.
+ *
+ * @return Whether a complete block was read
+ */
+bool readScpResultsBlock (ifstream &fin, vector<ScpResultRecord> &records) {
+	uint32_t counts[5];
+	if (!readBinary(fin, counts, 5) || counts[0] != kResultsBlockMarker)
+		return false;
+	uint32_t record_count = counts[1];
+	vector<uint32_t> key_lengths(record_count), algorithm_lengths(record_count);
+	vector<uint32_t> selected_lengths(record_count);
+	string keys(counts[2], '\0'), algorithms(counts[3], '\0');
+	vector<int64_t> total_costs(record_count), reference_totals(record_count);
+	vector<double> runtimes(record_count);
+	vector<int32_t> selected(counts[4]);
+	bool ok = readBinary(fin, key_lengths.data(), record_count) &&
+		readBinary(fin, &keys[0], keys.size()) &&
+		readBinary(fin, algorithm_lengths.data(), record_count) &&
+		readBinary(fin, &algorithms[0], algorithms.size()) &&
+		readBinary(fin, total_costs.data(), record_count) &&
+		readBinary(fin, reference_totals.data(), record_count) &&
+		readBinary(fin, runtimes.data(), record_count) &&
+		readBinary(fin, selected_lengths.data(), record_count) &&
+		readBinary(fin, selected.data(), selected.size());
+	if (!ok) return false;
+	size_t key_start = 0, algorithm_start = 0, selected_start = 0;
+	for (int i = 0; i < record_count; i++) {
+		ScpResultRecord record;
+		record.instance_key = keys.substr(key_start, key_lengths[i]);
+		record.algorithm_id =
+			algorithms.substr(algorithm_start, algorithm_lengths[i]);
+		record.total_cost = total_costs[i];
+		record.reference_total = reference_totals[i];
+		record.runtime = runtimes[i];
+		record.selected.assign(selected.begin() + selected_start,
+			selected.begin() + selected_start + selected_lengths[i]);
+		key_start += key_lengths[i];
+		algorithm_start += algorithm_lengths[i];
+		selected_start += selected_lengths[i];
+		records.push_back(record);
+	}
+	return true;
+}
+
+/**
+ * @brief Reads all records in a results file, using the index when present
+ * and otherwise scanning the blocks in order.
+ *
+ * @param results_path The path to the results file
+ * @return vector<ScpResultRecord> The records, in the order they were appended
+ */
+vector<ScpResultRecord> readScpResults (string results_path, ostream &log) {
+	vector<ScpResultRecord> records;
+	ifstream fin(results_path, std::ios::binary);
+	string magic(kResultsFileMagic.size(), '\0');
+	if (!fin.is_open() || !readBinary(fin, &magic[0], magic.size()) ||
+		magic != kResultsFileMagic) {
+		log << currentTimeMargin() << "Error: " << results_path <<
+			" is not a results file\n";
+		return records;
+	}
+
+	// The trailer holds [block count] [index offset] [index magic]
+	vector<uint64_t> block_offsets;
+	const int trailer_size = 2 * sizeof(uint64_t) + kResultsIndexMagic.size();
+	fin.seekg(0, std::ios::end);
+	long long file_size = fin.tellg();
+	if (file_size >= (long long)magic.size() + trailer_size) {
+		fin.seekg(file_size - trailer_size);
+		uint64_t block_count, index_offset;
+		string index_magic(kResultsIndexMagic.size(), '\0');
+		readBinary(fin, &block_count, 1);
+		readBinary(fin, &index_offset, 1);
+		readBinary(fin, &index_magic[0], index_magic.size());
+		if (index_magic == kResultsIndexMagic) {
+			fin.seekg(index_offset);
+			for (uint64_t i = 0; i < block_count; i++) {
+				uint64_t block_offset;
+				uint32_t record_count;
+				readBinary(fin, &block_offset, 1);
+				readBinary(fin, &record_count, 1);
+				block_offsets.push_back(block_offset);
+			}
+		}
+	}
+	fin.clear();
+
+	if (!block_offsets.empty()) {
+		for (uint64_t block_offset: block_offsets) {
+			fin.seekg(block_offset);
+			if (!readScpResultsBlock(fin, records)) {
+				log << currentTimeMargin() << "Error: Truncated block at " <<
+					block_offset << " in " << results_path << '\n';
+				break;
+			}
+		}
+	} else {
+		// No index (the run was interrupted), so recover whole blocks in order
+		fin.seekg(magic.size());
+		while (readScpResultsBlock(fin, records));
+	}
+	fin.close();
+	return records;
+}
+
+/**
+ * @brief Exports records as delimited text with one row per solution.
+ *
+ * @param delimiter ',' for CSV or '\t' for TSV (selected sets are separated by
+ * spaces in either case)
+ */
+void writeScpResultsDelimited (
+	vector<ScpResultRecord> &records, ostream &fout, char delimiter
+) {
+	fout << "instance" << delimiter << "algorithm" << delimiter <<
+		"total_cost" << delimiter << "reference_total" << delimiter <<
+		"runtime" << delimiter << "selected\n";
+	for (ScpResultRecord &record: records) {
+		fout << record.instance_key << delimiter << record.algorithm_id <<
+			delimiter << record.total_cost << delimiter <<
+			record.reference_total << delimiter << record.runtime << delimiter;
+		for (int i = 0; i < record.selected.size(); i++)
+			fout << (i ? " " : "") << record.selected[i];
+		fout << '\n';
+	}
+}
+
+/**
+ * @brief Rebuilds the tab-separated statistics files written by `main.cpp`
+ * from the records of random instances, whose keys have the form
+ * "rand-[format]-[n]x[m]-MC[max cost]-D[density]-S[seed]".
+ *
+ * @param output_directory The directory to write the statistics files to
+ */
+void writeScpStatsTables (
+	vector<ScpResultRecord> &records, string output_directory, ostream &log
+) {
+	// Densities may be printed in scientific notation (such as "1e-05")
+	const regex key_pattern("^rand-.*-(\\d+)x(\\d+)-MC(\\d+)-D(.+?)-S\\d+$");
+	// Groups (size, max cost) -> algorithm -> density -> stat -> samples
+	map<pair<string, string>, map<string, map<double, map<string,
+		vector<double>>>>> samples;
+	map<pair<string, string>, vector<string>> group_algorithm_ids;
+	map<pair<string, string>, vector<double>> group_densities;
+	map<pair<string, string>, bool> group_has_reference;
+	string previous_key;
+	long long exact_total = -1;
+	int skipped_count = 0;
+	for (ScpResultRecord &record: records) {
+		smatch match;
+		if (!regex_match(record.instance_key, match, key_pattern)) {
+			skipped_count++;
+			continue;
+		}
+		// `exact_total` is tracked per instance, as in `main.cpp`: it starts at
+		// the reference total, then takes the total of any exact algorithm
+		if (record.instance_key != previous_key)
+			exact_total = record.reference_total;
+		previous_key = record.instance_key;
+		if (record.algorithm_id.back() == 'E') exact_total = record.total_cost;
+
+		pair<string, string> group = {
+			match[1].str() + "x" + match[2].str(), match[3].str()
+		};
+		double density = stod(match[4].str());
+		if (record.reference_total > 0) group_has_reference[group] = true;
+		vector<string> &algorithm_ids = group_algorithm_ids[group];
+		if (find(algorithm_ids.begin(), algorithm_ids.end(),
+			record.algorithm_id) == algorithm_ids.end())
+			algorithm_ids.push_back(record.algorithm_id);
+		vector<double> &densities = group_densities[group];
+		if (find(densities.begin(), densities.end(), density) ==
+			densities.end())
+			densities.push_back(density);
+
+		map<string, vector<double>> &stats =
+			samples[group][record.algorithm_id][density];
+		stats["R"].push_back(record.runtime);
+		stats["TC"].push_back(record.total_cost);
+		stats["AR"].push_back(exact_total > 0 ?
+			(double)record.total_cost / exact_total : -1);
+	}
+	if (skipped_count) {
+		log << currentTimeMargin() << "Skipped " << skipped_count <<
+			" record(s) whose keys are not in the random instance format" << endl;
+	}
+
+	for (pair<const pair<string, string>, vector<string>> &entry:
+		group_algorithm_ids) {
+		const pair<string, string> &group = entry.first;
+		vector<string> &algorithm_ids = entry.second;
+		vector<double> &densities = group_densities[group];
+		sort(densities.begin(), densities.end());
+		string size_string_formatted = group.first;
+		size_string_formatted.replace(
+			size_string_formatted.find('x'), 1, " × "
+		);
+		size_t trial_count = 0;
+		for (string algorithm_id: algorithm_ids) {
+			for (double density: densities) {
+				trial_count = max(trial_count,
+					samples[group][algorithm_id][density]["R"].size());
+			}
+		}
+		for (string stat_id: kAlgorithmStatsIds) {
+			if (stat_id == "AR" && algorithm_ids.front().back() != 'E' &&
+				!group_has_reference[group])
+				continue;
+			string stats_file_name = "rand-" + group.first + "-MC" +
+				group.second + "-D";
+			for (double density: densities)
+				stats_file_name += doubleToString(density) + '-';
+			stats_file_name += "T" + to_string(trial_count);
+			for (string algorithm_id: algorithm_ids)
+				stats_file_name += '-' + algorithm_id;
+			stats_file_name += '-' + stat_id + ".txt";
+			log << currentTimeMargin() << "Writing statistics file " <<
+				stats_file_name << "..." << endl;
+			ofstream fout(output_directory + stats_file_name);
+			fout << kAlgorithmStats.at(stat_id) << ' ' << trial_count <<
+				"-trial averages (" << size_string_formatted <<
+				", max column cost " << group.second << ')' << endl;
+			fout << "Algorithm" << '\t';
+			for (double density: densities) fout << density << '\t';
+			fout << '\n';
+			for (string algorithm_id: algorithm_ids) {
+				fout << kAlgorithms.at(algorithm_id) << '\t';
+				for (double density: densities) {
+					vector<double> &data_list =
+						samples[group][algorithm_id][density][stat_id];
+					double sum = 0;
+					for (double x: data_list) sum += x;
+					fout << (data_list.empty() ? 0 : sum / data_list.size()) <<
+						'\t';
+				}
+				fout << '\n';
+			}
+			fout.close();
+		}
+	}
+}
@@ -4,6 +4,8 @@
  * instances with various algorithms, and writing SCP solutions to output files.
  */
 const double kDoubleInfinity = 1e18;
+// Number of greedy iterations covered by each trace span
+const int kTraceIterationBatch = 32;
 
 /**
  * @brief Reads an SCP instance from an input file and converts it to a
@@ -17,6 +19,7 @@ const double kDoubleInfinity = 1e18;
 unique_ptr<ScpInstance> readScpInstance (
 	string input_path, string input_format, ofstream &log_file
 ) {
+	ScpTraceSpan span("read", input_path);
 	ifstream fin(input_path);
 	if (fin.bad()) {
 		log_file << currentTimeMargin() << "An error occurred when reading " <<
@@ -64,20 +67,29 @@ unique_ptr<ScpInstance> readScpInstance (
  * 
  * @param input The SCP instance to solve
  * @param algorithm The algorithm to use
+ * @param arena The arena to allocate the solver's copy of the instance and its
+ * scratch arrays from, or null to use `std::allocator` (see `allocator.cpp`)
  * @return ScpSolution* 
  */
 unique_ptr<ScpSolution> solveScpInstance (
-	unique_ptr<ScpInstance> &input, string algorithm, ofstream &log_file
+	unique_ptr<ScpInstance> &input, string algorithm, ofstream &log_file,
+	ScpArena *arena = nullptr
 ) {
+	// Frees the arena's allocations when the solver returns
+	ScpArenaScope arena_scope(arena);
 	int N = input->n, M = input->m;
-	vector<int> costs = input->costs;
-	vector<vector<int>> rows = input->rows, columns = input->columns;
+	ScpTraceSpan copy_span("copy", algorithm);
+	ScpVector<int> costs(input->costs.begin(), input->costs.end(), arena);
+	// The rows and columns are copied into contiguous arrays
+	ScpAdjacency rows(input->rows, arena), columns(input->columns, arena);
+	copy_span.end();
 	unique_ptr<ScpSolution> solution(new ScpSolution());
 
 	// Checks that a solution exists in O(∑|S_i|)
+	ScpTraceSpan check_span("check", algorithm);
 	vector<bool> exists(N); // exists[i] holds whether i exists in any column
-	for (vector<int> column: columns) {
-		for (int r: column) exists[r] = true;
+	for (int c = 0; c < M; c++) {
+		for (int r: columns[c]) exists[r] = true;
 	}
 	for (int c = 0; c < N; c++) {
 		if (!exists[c]) {
@@ -86,6 +98,9 @@ unique_ptr<ScpSolution> solveScpInstance (
 			return solution;
 		}
 	}
+	check_span.end();
+
+	ScpTraceSpan solve_span("solve", algorithm);
 
 	auto start_time = system_clock::now(); 
 
@@ -93,12 +108,14 @@ unique_ptr<ScpSolution> solveScpInstance (
 	 * column_sizes[i] holds the number of uncovered elements remaining in
 	 * column i
 	 */
-	vector<int> column_sizes; // Gets updated and used in the greedy algos
-	for (vector<int> column: columns) column_sizes.push_back(column.size());
-	// in_union[r] holds whether r is in the union of all selected sets
-	vector<bool> in_union(N);
+	// Gets updated and used in the greedy algos
+	ScpVector<int> column_sizes(M, 0, arena);
+	for (int c = 0; c < M; c++) column_sizes[c] = columns[c].size();
+	// in_union[r] holds whether r is in the union of all selected sets (a byte
+	// per element, unlike `vector<bool>`, for cheaper random access)
+	ScpVector<char> in_union(N, false, arena);
 	int union_size = 0;
-	vector<double> unit_costs(M, kDoubleInfinity);
+	ScpVector<double> unit_costs(M, kDoubleInfinity, arena);
 	int best_c = 0; // Index of the best column (lowest unit cost)
 
 	if (algorithm == "NG") {
@@ -115,7 +132,9 @@ unique_ptr<ScpSolution> solveScpInstance (
 		 * 
 		 * O(mn) memory
 		 */
-		while (union_size < N) {
+		ScpTraceSpan batch_span("NG iterations");
+		for (int iteration = 1; union_size < N; iteration++) {
+			if (iteration % kTraceIterationBatch == 0) batch_span.restart();
 			for (int c = 0; c < M; c++) {
 				column_sizes[c] = 0;
 				for (int r: columns[c]) {
@@ -154,7 +173,9 @@ unique_ptr<ScpSolution> solveScpInstance (
 		for (int c = 0; c < M; c++)
 			if (column_sizes[c])
 				unit_costs[c] = double(costs[c]) / column_sizes[c];
-		while (union_size < N) {
+		ScpTraceSpan batch_span("OG iterations");
+		for (int iteration = 1; union_size < N; iteration++) {
+			if (iteration % kTraceIterationBatch == 0) batch_span.restart();
 			for (int c = 0; c < M; c++)
 				if (unit_costs[c] < unit_costs[best_c]) best_c = c;
 			solution->selected.push_back(best_c);
@@ -186,7 +207,7 @@ unique_ptr<ScpSolution> solveScpInstance (
 		// x is a bitmask encoding the sets in the subfamily
 		// The c-th bit from the end of x encodes S_c
 		for (long long x = 0; x < (1LL << M); x++) {
-			in_union = vector<bool>(N);
+			in_union.assign(N, false);
 			long long next_total = 0;
 			vector<int> next_selected;
 			for (int c = 0; c < M; c++) {
@@ -215,7 +236,7 @@ unique_ptr<ScpSolution> solveScpInstance (
 		 * O(2^n) mem
 		 */
 		// Stores minimum total costs for each subset of U by DP
-		vector<long long> dp_totals(1LL << N, 1e18);
+		ScpVector<long long> dp_totals(1LL << N, 1e18, arena);
 		dp_totals[0] = 0;
 		// Stores the corresponding subfamilies of S used, as bitmask strings
 		vector<string> dp_subfamilies(1LL << N);
@@ -265,6 +286,7 @@ unique_ptr<ScpSolution> solveScpInstance (
  * @param output_path The path to the output file
  */
 void writeScpSolution (unique_ptr<ScpSolution> &solution, string output_path) {
+	ScpTraceSpan span("write-solution", output_path);
 	ofstream fout(output_path);
 	fout << "Number of sets: " << solution->selected.size() << '\n';
 	fout << "Total cost: " << solution->total_cost << '\n';
@@ -0,0 +1,131 @@
+/**
+ * @file trace.cpp
+ * @brief This file contains lightweight scoped spans for tracing where time
+ * goes in a run, and exports them as Chrome trace-event JSON, which can be
+ * opened in https://ui.perfetto.dev or chrome://tracing.
+ *
+ * Tracing is off unless the `SCP_TRACE` environment variable is set (to any
+ * value other than "0"). While it is off, a span costs a single branch when it
+ * starts and another when it ends.
+ */
+
+/**
+ * @brief A completed span, with times in microseconds since the tracer started.
+ */
+struct ScpTraceEvent {
+	const char *name;
+	string detail;
+	double start, duration;
+	int thread;
+};
+
+/**
+ * @brief Collects the spans of all threads.
+ */
+class ScpTracer {
+ public:
+	bool enabled = false;
+
+	ScpTracer () {
+		const char *setting = getenv("SCP_TRACE");
+		enabled = setting && *setting && string(setting) != "0";
+		epoch = steady_clock::now();
+	}
+
+	// Microseconds since the tracer started
+	double now () {
+		duration<double, std::micro> elapsed = steady_clock::now() - epoch;
+		return elapsed.count();
+	}
+
+	void record (const char *name, string &detail, double start, double end) {
+		// Threads are numbered in the order they first record a span
+		thread_local int thread = next_thread++;
+		std::lock_guard<std::mutex> lock(events_mutex);
+		events.push_back({name, detail, start, end - start, thread});
+	}
+
+	/**
+	 * @brief Writes all spans recorded so far as a Chrome trace-event JSON
+	 * file.
+	 *
+	 * @param trace_path The path to the trace file
+	 */
+	void writeChromeTrace (string trace_path) {
+		std::lock_guard<std::mutex> lock(events_mutex);
+		ofstream fout(trace_path);
+		// Fixed-point microseconds keep nanosecond resolution in long runs
+		fout << fixed << setprecision(3);
+		fout << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+		for (int i = 0; i < events.size(); i++) {
+			ScpTraceEvent &event = events[i];
+			fout << "{\"name\": \"" << escapeJson(event.name) <<
+				"\", \"cat\": \"scp\", \"ph\": \"X\", \"pid\": 1, \"tid\": " <<
+				event.thread << ", \"ts\": " << event.start << ", \"dur\": " <<
+				event.duration;
+			if (!event.detail.empty())
+				fout << ", \"args\": {\"detail\": \"" <<
+					escapeJson(event.detail) << "\"}";
+			fout << '}' << (i + 1 < events.size() ? "," : "") << '\n';
+		}
+		fout << "]}\n";
+		fout.close();
+	}
+
+ private:
+	steady_clock::time_point epoch;
+	std::mutex events_mutex;
+	vector<ScpTraceEvent> events;
+	std::atomic<int> next_thread{0};
+
+	static string escapeJson (string text) {
+		string result;
+		for (char x: text) {
+			if (x == '"' || x == '\\') result += '\\';
+			if ((unsigned char)x < 0x20) continue;
+			result += x;
+		}
+		return result;
+	}
+};
+
+ScpTracer scp_tracer;
+
+/**
+ * @brief Records the time from its construction to its destruction (or to
+ * `end()`) as a span, if tracing is enabled.
+ */
+class ScpTraceSpan {
+ public:
+	// `detail` is copied only when tracing is enabled.
+	explicit ScpTraceSpan (const char *name, const string &detail = "") {
+		active = scp_tracer.enabled;
+		if (!active) return;
+		this->name = name;
+		this->detail = detail;
+		start = scp_tracer.now();
+	}
+	~ScpTraceSpan () { end(); }
+
+	// Ends the span early.
+	void end () {
+		if (!active) return;
+		scp_tracer.record(name, detail, start, scp_tracer.now());
+		active = false;
+	}
+
+	// Ends the span and starts an identical one, such as for the next batch of
+	// iterations of a loop.
+	void restart () {
+		if (!active) return;
+		double split = scp_tracer.now();
+		scp_tracer.record(name, detail, start, split);
+		start = split;
+	}
+
+ private:
+	bool active;
+	const char *name;
+	string detail;
+	double start;
+};